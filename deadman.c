@@ -0,0 +1,177 @@
+/*
+ * This file is part of VTMotor (I2C motor driver)
+ *
+ * Copyright 2012-2014 Vitaly Perov <vitperov@gmail.com>
+ *
+ * VTMotor is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VTMotor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <avr/io.h>
+#include <avr/wdt.h>
+
+#include "deadman.h"
+#include "motor.h"
+#include "motion_queue.h"
+#include "motor_driver_commands.h"
+
+/* Settings */
+#define WDT_TIMEOUT     WDTO_250MS
+
+/* internal variables */
+static uint16_t m_timeout, m_idle;
+static uint8_t m_mode, m_ramp_step;
+static uint8_t m_expired, m_stopped;
+static uint8_t m_tripped, m_wdt_reset;
+
+/********************
+ * HELPER FUNCTIONS *
+ ********************/
+
+static void deadman_expire()
+{
+  m_expired = 1;
+  m_stopped = 1;
+  m_tripped = 1;
+
+  /* Queued segments must not override the safe-stop */
+  mq_stop();
+
+  switch (m_mode & DRV_SAFE_STOP_MODE_MASK)
+  {
+  case DRV_SAFE_STOP_RAMP:
+    m_stopped = 0;
+    break;
+  case DRV_SAFE_STOP_BRAKE:
+    drv_set_speed(0, 0);
+    break;
+  case DRV_SAFE_STOP_DISABLE:
+    drv_set_speed(0, 0);
+    drv_disable();
+    break;
+  }
+}
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+void conf_deadman()
+{
+  m_timeout = 0; /* disabled until configured by host */
+  m_idle = 0;
+  m_mode = DRV_SAFE_STOP_BRAKE;
+  m_ramp_step = 0;
+  m_expired = 0;
+  m_stopped = 0;
+  m_tripped = 0;
+
+  /* Remember a watchdog reset until the host configures us again */
+  m_wdt_reset = (MCUCSR & _BV(WDRF)) ? 1 : 0;
+  MCUCSR &= ~_BV(WDRF);
+
+  wdt_enable(WDT_TIMEOUT);
+}
+
+/*
+ * Called from the PWM interrupt once per PWM period. Also feeds the
+ * hardware watchdog, so a hung timer interrupt resets the chip.
+ */
+void deadman_period()
+{
+  if (m_timeout)
+  {
+    if (!m_expired && ++m_idle >= m_timeout)
+      deadman_expire();
+
+    if (m_expired && !m_stopped)
+      m_stopped = !drv_ramp_down(m_ramp_step);
+
+    /*
+     * Stop feeding the watchdog: the reset brings up a fresh TWI state
+     * machine with the drivers disabled.
+     */
+    if (m_stopped && (m_mode & DRV_SAFE_STOP_RESET))
+      return;
+  }
+
+  wdt_reset();
+}
+
+/* Called on every valid SMBus command, does not cancel a safe-stop */
+void deadman_refresh()
+{
+  m_idle = 0;
+}
+
+/* Called on commands that set motion, cancels a safe-stop */
+void deadman_override()
+{
+  m_idle = 0;
+  m_expired = 0;
+  m_stopped = 0;
+}
+
+/*
+ * Timeout is in PWM periods, 0 disables the deadman. Returns 0 on
+ * success.
+ */
+uint8_t deadman_configure(uint16_t timeout, uint8_t mode, uint8_t ramp_step)
+{
+  /* Mode and ramp step are unused while disabled */
+  if (timeout)
+  {
+    switch (mode & DRV_SAFE_STOP_MODE_MASK)
+    {
+    case DRV_SAFE_STOP_RAMP:
+      if (!ramp_step)
+        return 1;
+      break;
+    case DRV_SAFE_STOP_BRAKE:
+    case DRV_SAFE_STOP_DISABLE:
+      break;
+    default:
+      return 1;
+    }
+
+    if (mode & ~(DRV_SAFE_STOP_MODE_MASK | DRV_SAFE_STOP_RESET))
+      return 1;
+  }
+
+  m_timeout = timeout;
+  m_mode = mode;
+  m_ramp_step = ramp_step;
+  m_tripped = 0;
+  m_wdt_reset = 0;
+  deadman_override();
+
+  return 0;
+}
+
+/*
+ * Fills DRV_DEADMAN_STATUS response, returns its length. Reading the
+ * status clears the tripped flag.
+ */
+uint8_t deadman_status(uint8_t *buf)
+{
+  buf[0] = m_timeout & 0xFF;
+  buf[1] = m_timeout >> 8;
+  buf[2] = m_mode;
+  buf[3] = m_ramp_step;
+  buf[4] = (m_expired ? DRV_DEADMAN_EXPIRED : 0) |
+           (m_wdt_reset ? DRV_DEADMAN_WDT_RESET : 0) |
+           (m_tripped ? DRV_DEADMAN_TRIPPED : 0);
+  m_tripped = 0;
+
+  return 5;
+}
@@ -20,6 +20,8 @@
 #include <avr/io.h>
 
 #include "motor.h"
+#include "motion_queue.h"
+#include "deadman.h"
 #include "external/SMBSlave.h"
 
 /* TIMER */
@@ -39,6 +41,8 @@ inline void configure()
 
   conf_TMR0();
   conf_motors();
+  conf_motion_queue();
+  conf_deadman();
 
   SREG |= _BV(7); /* Enable interrupts */
 }
@@ -0,0 +1,193 @@
+/*
+ * This file is part of VTMotor (I2C motor driver)
+ *
+ * Copyright 2012-2014 Vitaly Perov <vitperov@gmail.com>
+ *
+ * VTMotor is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VTMotor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <avr/io.h>
+
+#include "motion_queue.h"
+#include "motor.h"
+#include "motor_driver_commands.h"
+
+#define MQ_MASK         (MQ_SIZE - 1)
+
+typedef struct mq_segment
+{
+  uint8_t  flags;      /* DRV_SEG_* */
+  uint8_t  speed1;
+  uint8_t  speed2;
+  uint16_t periods;    /* duration in PWM periods */
+} mq_segment;
+
+/* internal variables */
+static mq_segment m_queue[MQ_SIZE];
+static uint8_t m_head, m_count;
+static uint8_t m_running, m_primed, m_starved, m_end_pending;
+static uint8_t m_underruns;
+static uint16_t m_remaining;
+
+/********************
+ * HELPER FUNCTIONS *
+ ********************/
+
+static void mq_apply(const mq_segment *seg)
+{
+  drv_set_direction(
+    (seg->flags & DRV_SEG_DIR1_BACK) ? DRV_DIR_BACK : DRV_DIR_FORWARD,
+    (seg->flags & DRV_SEG_DIR2_BACK) ? DRV_DIR_BACK : DRV_DIR_FORWARD);
+  drv_set_speed(seg->speed1, seg->speed2);
+}
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+void conf_motion_queue()
+{
+  m_head = 0;
+  m_count = 0;
+  m_running = 0;
+  m_primed = 0;
+  m_starved = 0;
+  m_end_pending = 0;
+  m_underruns = 0;
+  m_remaining = 0;
+}
+
+/*
+ * Called from the PWM interrupt at the start of every PWM period, so
+ * segments always switch on an exact period boundary.
+ */
+void mq_period()
+{
+  mq_segment *seg;
+
+  if (!m_running)
+    return;
+
+  if (m_remaining && --m_remaining)
+    return;
+
+  /* Current segment is over (or none was loaded yet) */
+  if (m_end_pending)
+  {
+    m_running = 0;
+    m_end_pending = 0;
+    drv_set_speed(0, 0);
+    return;
+  }
+
+  if (!m_count)
+  {
+    /* Started before upload: wait for the first segment */
+    if (!m_primed)
+      return;
+
+    /* Host did not append in time: stop and wait for more segments */
+    if (!m_starved)
+    {
+      m_starved = 1;
+      if (m_underruns != 0xFF)
+        m_underruns++;
+      drv_set_speed(0, 0);
+    }
+    return;
+  }
+
+  seg = &m_queue[m_head];
+  m_head = (m_head + 1) & MQ_MASK;
+  m_count--;
+
+  m_primed = 1;
+  m_starved = 0;
+  m_remaining = seg->periods;
+  m_end_pending = seg->flags & DRV_SEG_END;
+  mq_apply(seg);
+}
+
+/*
+ * Append segments in wire format (DRV_SEG_SIZE bytes each). Either all
+ * segments are queued or none. Returns 0 on success.
+ */
+uint8_t mq_append(const uint8_t *data, uint8_t count)
+{
+  uint8_t n, i, tail;
+  mq_segment *seg;
+
+  if (!count || count % DRV_SEG_SIZE)
+    return 1;
+
+  n = count / DRV_SEG_SIZE;
+  if (n > MQ_SIZE - m_count)
+    return 1;
+
+  for (i = 0; i < count; i += DRV_SEG_SIZE)
+    if (!data[i + 3] && !data[i + 4])
+      return 1; /* zero duration */
+
+  tail = (m_head + m_count) & MQ_MASK;
+  for (i = 0; i < count; i += DRV_SEG_SIZE)
+  {
+    seg = &m_queue[tail];
+    seg->flags   = data[i];
+    seg->speed1  = data[i + 1];
+    seg->speed2  = data[i + 2];
+    seg->periods = data[i + 3] | ((uint16_t)data[i + 4] << 8);
+    tail = (tail + 1) & MQ_MASK;
+  }
+  m_count += n;
+
+  return 0;
+}
+
+/* Does nothing while playback is running, so a resent START is harmless */
+void mq_start()
+{
+  if (m_running)
+    return;
+
+  m_underruns = 0;
+  m_primed = 0;
+  m_remaining = 0;
+  m_starved = 0;
+  m_end_pending = 0;
+  m_running = 1;
+}
+
+void mq_stop()
+{
+  m_running = 0;
+  m_head = 0;
+  m_count = 0;
+  m_remaining = 0;
+  m_end_pending = 0;
+}
+
+uint8_t mq_fill()
+{
+  return m_count;
+}
+
+uint8_t mq_underruns()
+{
+  return m_underruns;
+}
+
+uint8_t mq_running()
+{
+  return m_running;
+}
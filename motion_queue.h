@@ -0,0 +1,39 @@
+/*
+ * This file is part of VTMotor (I2C motor driver)
+ *
+ * Copyright 2012-2014 Vitaly Perov <vitperov@gmail.com>
+ *
+ * VTMotor is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VTMotor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MOTION_QUEUE_H
+#define _MOTION_QUEUE_H
+
+#include <stdint.h>
+
+/* Number of segments the queue can hold (must be a power of 2) */
+#define MQ_SIZE         32
+
+void conf_motion_queue();
+void mq_period();
+
+uint8_t mq_append(const uint8_t *data, uint8_t count);
+void mq_start();
+void mq_stop();
+
+uint8_t mq_fill();
+uint8_t mq_underruns();
+uint8_t mq_running();
+
+#endif
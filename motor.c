@@ -22,6 +22,8 @@
 
 #include "motor.h"
 #include "motor_driver_commands.h"
+#include "motion_queue.h"
+#include "deadman.h"
 
 /* Settings */
 #define TMR_RELOAD      50 /* PWM frequency = 200 Hz */
@@ -132,6 +134,9 @@ void inline motors_pwm()
 {
   if (!m_pwm_cnt)
   {
+    mq_period();
+    deadman_period();
+
     if (m_speed1)
       drv1_turn_on();
     if (m_speed2)
@@ -181,6 +186,15 @@ inline void drv_set_speed(uint8_t left, uint8_t right)
   m_speed2 = right;
 }
 
+/* Returns nonzero while any channel is still running */
+uint8_t drv_ramp_down(uint8_t step)
+{
+  m_speed1 = (m_speed1 > step) ? m_speed1 - step : 0;
+  m_speed2 = (m_speed2 > step) ? m_speed2 - step : 0;
+
+  return m_speed1 || m_speed2;
+}
+
 inline void drv_set_direction(uint8_t left, uint8_t right)
 {
   if (DRV_DIR_FORWARD == left)
@@ -28,5 +28,6 @@ void drv_disable();
 
 inline void drv_set_direction(uint8_t left, uint8_t right);
 inline void drv_set_speed    (uint8_t left, uint8_t right);
+uint8_t drv_ramp_down(uint8_t step);
 
 #endif
@@ -23,8 +23,58 @@
 #define DRV_DRV_DISABLE     0x12
 #define DRV_SET_SPEED       0x13
 #define DRV_SET_DIRECTION   0x14
+#define DRV_QUEUE_WRITE     0x15
+#define DRV_QUEUE_START     0x16
+#define DRV_QUEUE_STOP      0x17
+#define DRV_QUEUE_STATUS    0x18
+#define DRV_SET_TIMEOUT     0x19
+#define DRV_DEADMAN_STATUS  0x1A
 
 #define DRV_DIR_FORWARD     0x0
 #define DRV_DIR_BACK        0x1
 
+/*
+ * Motion queue segment, DRV_SEG_SIZE bytes, sent with DRV_QUEUE_WRITE
+ * as an SMBus block write (up to 6 segments per write):
+ *   flags, speed1, speed2, duration low, duration high
+ * Duration is in PWM periods and must not be 0.
+ * DRV_QUEUE_START is ignored while playback is running; playback may be
+ * started before the first upload.
+ * DRV_QUEUE_STATUS returns: fill level, underrun count, running flag.
+ */
+#define DRV_SEG_SIZE        5
+
+#define DRV_SEG_DIR1_BACK   0x01
+#define DRV_SEG_DIR2_BACK   0x02
+#define DRV_SEG_END         0x80 /* stop playback after this segment */
+
+/*
+ * Deadman timeout, set with DRV_SET_TIMEOUT:
+ *   timeout low, timeout high, mode, ramp step
+ * Timeout is in PWM periods since the last valid command, 0 disables it.
+ * Mode and ramp step are ignored when disabling.
+ * Ramp step is the duty decrement per PWM period for DRV_SAFE_STOP_RAMP.
+ * Once started, the safe-stop runs to completion; only DRV_SET_SPEED,
+ * DRV_QUEUE_START or DRV_SET_TIMEOUT cancel it.
+ * Queue playback does not restart the timeout; expiry flushes the queue.
+ * With DRV_SAFE_STOP_RESET the watchdog resets the board after the stop.
+ * The configuration does NOT survive that reset: the board boots with the
+ * deadman disabled and DRV_DEADMAN_WDT_RESET set until DRV_SET_TIMEOUT.
+ *
+ * DRV_DEADMAN_STATUS returns:
+ *   timeout low, timeout high, mode, ramp step, flags
+ * DRV_DEADMAN_EXPIRED is set while a safe-stop is in force.
+ * DRV_DEADMAN_TRIPPED latches on expiry and is cleared by this status read
+ * or by DRV_SET_TIMEOUT.
+ */
+#define DRV_SAFE_STOP_RAMP      0x0
+#define DRV_SAFE_STOP_BRAKE     0x1
+#define DRV_SAFE_STOP_DISABLE   0x2
+#define DRV_SAFE_STOP_MODE_MASK 0x3
+#define DRV_SAFE_STOP_RESET     0x80
+
+#define DRV_DEADMAN_EXPIRED     0x01
+#define DRV_DEADMAN_WDT_RESET   0x02
+#define DRV_DEADMAN_TRIPPED     0x04
+
 #define DRV_WHO_AM_I_RESPONSE   0x47
@@ -23,12 +23,20 @@
 #include "smbus_commands.h"
 #include "motor_driver_commands.h"
 #include "motor.h"
+#include "motion_queue.h"
+#include "deadman.h"
 
 static void WhoAmI(SMBData *smb);
 static void EnableMotors(SMBData *smb);
 static void DisableMotors(SMBData *smb);
 static void SetSpeed(SMBData *smb);
 static void SetDerection(SMBData *smb);
+static void QueueWrite(SMBData *smb);
+static void QueueStart(SMBData *smb);
+static void QueueStop(SMBData *smb);
+static void QueueStatus(SMBData *smb);
+static void SetTimeout(SMBData *smb);
+static void DeadmanStatus(SMBData *smb);
 static void UndefinedCommand(SMBData *smb);
 static void UndefinedCommand(SMBData *smb);
 
@@ -64,10 +72,31 @@ void ProcessMessage(SMBData *smb)
   case DRV_DRV_DISABLE:
     DisableMotors(smb);
     break;
+  case DRV_QUEUE_WRITE:
+    QueueWrite(smb);
+    break;
+  case DRV_QUEUE_START:
+    QueueStart(smb);
+    break;
+  case DRV_QUEUE_STOP:
+    QueueStop(smb);
+    break;
+  case DRV_QUEUE_STATUS:
+    QueueStatus(smb);
+    break;
+  case DRV_SET_TIMEOUT:
+    SetTimeout(smb);
+    break;
+  case DRV_DEADMAN_STATUS:
+    DeadmanStatus(smb);
+    break;
   default:
     UndefinedCommand(smb);
   break;
   }
+
+  if (!smb->error)
+    deadman_refresh();
 }
 
 static inline void WhoAmI(SMBData *smb)
@@ -114,6 +143,7 @@ static inline void SetSpeed(SMBData *smb)
   }
 
   drv_set_speed(smb->rxBuffer[1], smb->rxBuffer[2]);
+  deadman_override();
 
   smb->state = SMB_STATE_IDLE;
 }
@@ -131,6 +161,85 @@ static inline void SetDerection(SMBData *smb)
   smb->state = SMB_STATE_IDLE;
 }
 
+static inline void QueueWrite(SMBData *smb)
+{
+  // Block write: command, byte count, segments.
+  if (smb->rxCount < 2 || smb->rxCount != smb->rxBuffer[1] + 2)
+  {
+    smb->error = TRUE;
+    return;
+  }
+
+  if (mq_append(&smb->rxBuffer[2], smb->rxBuffer[1]))
+  {
+    smb->error = TRUE;
+    return;
+  }
+
+  smb->state = SMB_STATE_IDLE;
+}
+
+static inline void QueueStart(SMBData *smb)
+{
+  if (smb->rxCount != 1)
+  {
+    smb->error = TRUE;
+    return;
+  }
+
+  mq_start();
+  deadman_override();
+
+  smb->state = SMB_STATE_IDLE;
+}
+
+static inline void QueueStop(SMBData *smb)
+{
+  if (smb->rxCount != 1)
+  {
+    smb->error = TRUE;
+    return;
+  }
+
+  mq_stop();
+  drv_set_speed(0, 0);
+
+  smb->state = SMB_STATE_IDLE;
+}
+
+static inline void QueueStatus(SMBData *smb)
+{
+  smb->txBuffer[0] = mq_fill();
+  smb->txBuffer[1] = mq_underruns();
+  smb->txBuffer[2] = mq_running();
+  smb->txLength = 3;
+  smb->state = SMB_STATE_WRITE_READ_REQUESTED;
+}
+
+static inline void SetTimeout(SMBData *smb)
+{
+  if (smb->rxCount != 5)
+  {
+    smb->error = TRUE;
+    return;
+  }
+
+  if (deadman_configure(smb->rxBuffer[1] | ((uint16_t)smb->rxBuffer[2] << 8),
+                        smb->rxBuffer[3], smb->rxBuffer[4]))
+  {
+    smb->error = TRUE;
+    return;
+  }
+
+  smb->state = SMB_STATE_IDLE;
+}
+
+static inline void DeadmanStatus(SMBData *smb)
+{
+  smb->txLength = deadman_status(smb->txBuffer);
+  smb->state = SMB_STATE_WRITE_READ_REQUESTED;
+}
+
 static inline void UndefinedCommand(SMBData *smb)
 {
   // Handle undefined requests here.